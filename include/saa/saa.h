@@ -8,7 +8,9 @@ extern "C" {
 #include <stdbool.h>
 
 typedef struct saa_arena_page_t saa_arena_page;
+typedef struct saa_arena_spares_t saa_arena_spares;
 typedef struct saa_arena_t saa_arena;
+typedef struct saa_frame_arena_t saa_frame_arena;
 
 struct saa_arena_page_t
 {
@@ -17,14 +19,35 @@ struct saa_arena_page_t
     size_t capacity;
 };
 
+// Note: pool of preallocated pages handed out by saa_arena_push on page crossing
+struct saa_arena_spares_t
+{
+    saa_arena_page *pages;
+    size_t count;
+    size_t target;
+    size_t low_watermark;
+};
+
 struct saa_arena_t
 {
     saa_arena_page *pages;
+    saa_arena_spares *spares;
     size_t page_size;
 };
 
+// Note: ring of arenas, newest generation is pushed to while older ones stay alive until advanced over
+struct saa_frame_arena_t
+{
+    saa_arena *generations;
+    size_t generation_count;
+    size_t current;
+};
+
 static inline saa_arena saa_arena_create(const size_t size);
+static inline saa_arena saa_arena_create_prefetched(const size_t size, const size_t spare_pages, const size_t low_watermark);
+static inline size_t saa_arena_prefetch(const saa_arena *restrict arena);
 static inline void *saa_arena_push(const saa_arena *restrict arena, size_t lenght);
+static inline void *saa_arena_push_aligned(const saa_arena *restrict arena, size_t lenght, size_t alignment);
 static inline double *saa_arena_push_value_double(const saa_arena *restrict arena, double value);
 static inline float *saa_arena_push_value_float(const saa_arena *restrict arena, float value);
 static inline int *saa_arena_push_value_int(const saa_arena *restrict, int value);
@@ -32,7 +55,13 @@ static inline bool *saa_arena_push_value_bool(const saa_arena *restrict arena, i
 static inline char *saa_arena_push_value_string(const saa_arena *restrict arena, const char *restrict value);
 static inline void *saa_arena_push_arbitrary(const saa_arena *restrict arena, const void *restrict value, size_t lenght);
 static inline void *saa_arena_blob_pages(const saa_arena *restrict arena);
+static inline void saa_arena_reset(saa_arena *restrict arena);
 static inline void saa_arena_destroy(const saa_arena *arena);
+static inline saa_frame_arena saa_frame_arena_create(const size_t size, const size_t generation_count);
+static inline saa_arena *saa_frame_arena_current(const saa_frame_arena *restrict frame);
+static inline saa_arena *saa_frame_arena_generation(const saa_frame_arena *restrict frame, size_t age);
+static inline saa_arena *saa_frame_arena_advance(saa_frame_arena *restrict frame);
+static inline void saa_frame_arena_destroy(const saa_frame_arena *frame);
 
 #define saa_arena_push_value_strings(arena, ...) \
     __saa_arena_push_value_strings(arena, (const char *[]){ __VA_ARGS__, NULL })
@@ -48,6 +77,16 @@ static inline char *__saa_arena_push_value_strings(const saa_arena *restrict are
     char *: saa_arena_push_value_string,                   \
     char **: __saa_arena_push_value_strings)(arena, type)
 
+#define saa_arena_push_array(arena, type, count) \
+    ((type *)__saa_arena_push_array(arena, sizeof(type), _Alignof(type), count))
+#define saa_arena_push_copy_n(arena, type, values, count) \
+    ((type *)__saa_arena_push_copy_n(arena, (const void *)(const type *){ (values) }, sizeof(type), _Alignof(type), count))
+#define saa_arena_push_fill(arena, type, value, count) \
+    ((type *)__saa_arena_push_fill(arena, (type[1]){ [0] = (value) }, sizeof(type), _Alignof(type), count))
+static inline void *__saa_arena_push_array(const saa_arena *restrict arena, size_t size, size_t alignment, size_t count);
+static inline void *__saa_arena_push_copy_n(const saa_arena *restrict arena, const void *restrict values, size_t size, size_t alignment, size_t count);
+static inline void *__saa_arena_push_fill(const saa_arena *restrict arena, const void *restrict value, size_t size, size_t alignment, size_t count);
+
 #ifdef __cplusplus
 }// extern "C"
 #endif
@@ -59,6 +98,7 @@ extern "C" {
 #endif
 
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
 
 static inline saa_arena_page *__saa_allocate_arena_page(const size_t page_size)
@@ -77,23 +117,120 @@ static inline saa_arena saa_arena_create(const size_t page_size)
     return (saa_arena){ .page_size = page_size, .pages = __saa_allocate_arena_page(page_size) };
 }
 
+static inline saa_arena_spares *__saa_arena_alloc_spares(const size_t target, const size_t low_watermark)
+{
+    saa_arena_spares *ret = (saa_arena_spares *)malloc(sizeof(*ret));
+    *ret = (saa_arena_spares){ .pages = NULL, .count = 0, .target = target, .low_watermark = low_watermark };
+    return ret;
+}
+
+// Note: keeps up to spare_pages preallocated pages so that page crossing pushes do not hit malloc,
+// saa_arena_prefetch refills them once no more than low_watermark are left
+static inline saa_arena saa_arena_create_prefetched(const size_t page_size, const size_t spare_pages, const size_t low_watermark)
+{
+    assert(page_size > 0);
+    assert(spare_pages == 0 || low_watermark < spare_pages);
+    saa_arena ret = saa_arena_create(page_size);
+    ret.spares = __saa_arena_alloc_spares(spare_pages, low_watermark);
+    (void)saa_arena_prefetch(&ret);
+    return ret;
+}
+
+// Note: tops the spare pool back up to its target once it drops to the low watermark, meant to be called during idle time,
+// returns number of pages allocated
+static inline size_t saa_arena_prefetch(const saa_arena *restrict arena)
+{
+    assert(arena != NULL);
+    saa_arena_spares *spares = arena->spares;
+    size_t allocated = 0;
+    if (spares == NULL || spares->count > spares->low_watermark) return 0;
+    for (; spares->count < spares->target; spares->count++, allocated++) {
+        saa_arena_page *page = __saa_allocate_arena_page(arena->page_size);
+        page->next = spares->pages;
+        spares->pages = page;
+    }
+    return allocated;
+}
+
+static inline saa_arena_page *__saa_arena_take_page(const saa_arena *restrict arena)
+{
+    saa_arena_spares *spares = arena->spares;
+    if (spares == NULL || spares->pages == NULL) return __saa_allocate_arena_page(arena->page_size);
+    saa_arena_page *ret = spares->pages;
+    spares->pages = ret->next;
+    spares->count--;
+    ret->next = NULL;
+    return ret;
+}
+
 static inline void *saa_arena_push(const saa_arena *restrict arena, size_t lenght)
+{
+    return saa_arena_push_aligned(arena, lenght, 1);
+}
+
+// Note: alignment must be a power of two, padding is counted in page capacity and shows up as gap bytes in
+// saa_arena_blob_pages (stale data after saa_arena_reset), returns NULL if the padded run does not fit a fresh page
+static inline void *saa_arena_push_aligned(const saa_arena *restrict arena, size_t lenght, size_t alignment)
 {
     assert(arena != NULL);
     assert(lenght > 0);
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
     void *ret_ptr = NULL;
     saa_arena_page *latest_page = NULL;
+    size_t padding = 0;
     if (lenght > arena->page_size) return NULL;
     for (latest_page = arena->pages; latest_page->next != NULL; latest_page = latest_page->next) {}
-    if (latest_page->capacity + lenght > arena->page_size) {
-        latest_page->next = __saa_allocate_arena_page(arena->page_size);
+    padding = -(uintptr_t)(latest_page->data + latest_page->capacity) & (alignment - 1);
+    if (latest_page->capacity + padding + lenght > arena->page_size) {
+        latest_page->next = __saa_arena_take_page(arena);
         latest_page = latest_page->next;
+        padding = -(uintptr_t)latest_page->data & (alignment - 1);
+        if (padding + lenght > arena->page_size) return NULL;
     }
-    ret_ptr = (void *)(latest_page->data + latest_page->capacity);
-    latest_page->capacity += lenght;
+    ret_ptr = (void *)(latest_page->data + latest_page->capacity + padding);
+    latest_page->capacity += padding + lenght;
     return ret_ptr;
 }
 
+// Note: returns NULL for an empty run
+static inline void *__saa_arena_push_array(const saa_arena *restrict arena, size_t size, size_t alignment, size_t count)
+{
+    assert(size > 0);
+    if (count == 0 || count > SIZE_MAX / size) return NULL;
+    return saa_arena_push_aligned(arena, size * count, alignment);
+}
+
+static inline void *__saa_arena_push_copy_n(const saa_arena *restrict arena, const void *restrict values, size_t size, size_t alignment, size_t count)
+{
+    assert(values != NULL || count == 0);
+    void *ret = __saa_arena_push_array(arena, size, alignment, count);
+    if (ret == NULL) return NULL;
+    memcpy(ret, values, size * count);
+    return ret;
+}
+
+// Note: fills by doubling memcpy so the bulk of the run goes through wide copies, single byte patterns use memset
+static inline void *__saa_arena_push_fill(const saa_arena *restrict arena, const void *restrict value, size_t size, size_t alignment, size_t count)
+{
+    assert(value != NULL);
+    const unsigned char *bytes = (const unsigned char *)value;
+    char *ret = (char *)__saa_arena_push_array(arena, size, alignment, count);
+    size_t filled = size;
+    const size_t total = size * count;
+    if (ret == NULL) return NULL;
+    if (size == 1 || memcmp(bytes, bytes + 1, size - 1) == 0) {
+        memset(ret, bytes[0], total);
+        return ret;
+    }
+    memcpy(ret, value, size);
+    while (filled < total) {
+        const size_t chunk = filled < total - filled ? filled : total - filled;
+        memcpy(ret + filled, ret, chunk);
+        filled += chunk;
+    }
+    return ret;
+}
+
 static inline void *saa_arena_push_arbitrary(const saa_arena *restrict arena, const void *restrict value, size_t lenght)
 {
     assert(arena != NULL);
@@ -167,10 +304,8 @@ static inline char *__saa_arena_push_value_strings(const saa_arena *restrict are
     return ret;
 }
 
-static inline void saa_arena_destroy(const saa_arena *arena)
+static inline void __saa_free_arena_pages(saa_arena_page *page)
 {
-    assert(arena != NULL);
-    saa_arena_page *page = arena->pages;
     while (page != NULL) {
         saa_arena_page *tmp = page->next;
         free(page->data);
@@ -179,6 +314,80 @@ static inline void saa_arena_destroy(const saa_arena *arena)
     }
 }
 
+static inline void saa_arena_destroy(const saa_arena *arena)
+{
+    assert(arena != NULL);
+    __saa_free_arena_pages(arena->pages);
+    if (arena->spares != NULL) {
+        __saa_free_arena_pages(arena->spares->pages);
+        free(arena->spares);
+    }
+}
+
+// Note: keeps the first page and moves the rest to the spare pool, reused memory is not zeroed,
+// spares are kept until destroy so the arena never shrinks
+static inline void saa_arena_reset(saa_arena *restrict arena)
+{
+    assert(arena != NULL);
+    saa_arena_page *page = arena->pages->next;
+    arena->pages->capacity = 0;
+    arena->pages->next = NULL;
+    if (page == NULL) return;
+    if (arena->spares == NULL) arena->spares = __saa_arena_alloc_spares(0, 0);
+    saa_arena_page *tail = page;
+    for (;; tail = tail->next) {
+        tail->capacity = 0;
+        arena->spares->count++;
+        if (tail->next == NULL) break;
+    }
+    tail->next = arena->spares->pages;
+    arena->spares->pages = page;
+}
+
+static inline saa_frame_arena saa_frame_arena_create(const size_t page_size, const size_t generation_count)
+{
+    assert(page_size > 0);
+    assert(generation_count > 1);
+    saa_frame_arena ret = { .generations = (saa_arena *)malloc(sizeof(*ret.generations) * generation_count), .generation_count = generation_count, .current = 0 };
+    for (size_t i = 0; i < generation_count; i++) {
+        ret.generations[i] = saa_arena_create(page_size);
+        ret.generations[i].spares = __saa_arena_alloc_spares(0, 0);
+    }
+    return ret;
+}
+
+static inline saa_arena *saa_frame_arena_current(const saa_frame_arena *restrict frame)
+{
+    assert(frame != NULL);
+    return &frame->generations[frame->current];
+}
+
+// Note: age 0 is the current generation, age generation_count - 1 is the oldest one
+static inline saa_arena *saa_frame_arena_generation(const saa_frame_arena *restrict frame, size_t age)
+{
+    assert(frame != NULL);
+    assert(age < frame->generation_count);
+    return &frame->generations[(frame->current + frame->generation_count - age) % frame->generation_count];
+}
+
+// Note: resets the oldest generation and makes it current, pointers into it are invalidated
+static inline saa_arena *saa_frame_arena_advance(saa_frame_arena *restrict frame)
+{
+    assert(frame != NULL);
+    frame->current = (frame->current + 1) % frame->generation_count;
+    saa_arena_reset(&frame->generations[frame->current]);
+    return &frame->generations[frame->current];
+}
+
+static inline void saa_frame_arena_destroy(const saa_frame_arena *frame)
+{
+    assert(frame != NULL);
+    for (size_t i = 0; i < frame->generation_count; i++) {
+        saa_arena_destroy(&frame->generations[i]);
+    }
+    free(frame->generations);
+}
+
 static inline void *saa_arena_blob_pages(const saa_arena *restrict arena)
 {
     size_t total_size = 0;
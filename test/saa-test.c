@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <stf/stf.h>
 
 #define SMB_IMPL
@@ -184,6 +185,277 @@ STF_TEST_CASE(saa, arena_blob_pages)
     free(blob);
     saa_arena_destroy(&arena);
 }
+
+STF_TEST_CASE(saa, arena_prefetched_keeps_spare_pages)
+{
+    static const size_t arena_page_size = 100;
+    static const size_t spare_pages = 3;
+    saa_arena arena = saa_arena_create_prefetched(arena_page_size, spare_pages, 0);
+    STF_EXPECT(arena.spares != NULL, .return_on_failure = true, .failure_msg = "spares are NULL");
+    STF_EXPECT(arena.spares->count == spare_pages, .failure_msg = "spare pool was not filled up to target");
+    STF_EXPECT(saa_arena_prefetch(&arena) == 0, .failure_msg = "prefetch on a full spare pool was not supposed to allocate");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_prefetched_page_crossing_uses_spare_page)
+{
+    static const size_t arena_page_size = 100;
+    static const size_t push_size = 60;
+    saa_arena arena = saa_arena_create_prefetched(arena_page_size, 1, 0);
+    STF_EXPECT(arena.spares != NULL, .return_on_failure = true, .failure_msg = "spares are NULL");
+    saa_arena_page *spare = arena.spares->pages;
+    (void)saa_arena_push(&arena, push_size);
+    char *pushed = saa_arena_push(&arena, push_size);
+    STF_EXPECT(pushed != NULL, .failure_msg = "pushing did not return a valid pointer");
+    STF_EXPECT(arena.pages->next == spare, .failure_msg = "page crossing push did not take the spare page");
+    STF_EXPECT(pushed == spare->data, .failure_msg = "pushed pointer is not at the start of the spare page");
+    STF_EXPECT(arena.spares->count == 0, .failure_msg = "spare pool was supposed to be empty");
+    STF_EXPECT(saa_arena_prefetch(&arena) == 1, .failure_msg = "prefetch was supposed to refill one page");
+    STF_EXPECT(arena.spares->count == 1, .failure_msg = "spare pool was not refilled");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_prefetch_waits_for_low_watermark)
+{
+    static const size_t arena_page_size = 100;
+    static const size_t push_size = 60;
+    saa_arena arena = saa_arena_create_prefetched(arena_page_size, 3, 1);
+    STF_EXPECT(arena.spares != NULL, .return_on_failure = true, .failure_msg = "spares are NULL");
+    (void)saa_arena_push(&arena, push_size);
+    (void)saa_arena_push(&arena, push_size);
+    STF_EXPECT(arena.spares->count == 2, .failure_msg = "page crossing push did not take a spare page");
+    STF_EXPECT(saa_arena_prefetch(&arena) == 0, .failure_msg = "prefetch above the low watermark was not supposed to allocate");
+    (void)saa_arena_push(&arena, push_size);
+    STF_EXPECT(arena.spares->count == 1, .failure_msg = "page crossing push did not take a spare page");
+    STF_EXPECT(saa_arena_prefetch(&arena) == 2, .failure_msg = "prefetch at the low watermark was supposed to refill up to target");
+    STF_EXPECT(arena.spares->count == 3, .failure_msg = "spare pool was not refilled");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_prefetch_without_spares_is_noop)
+{
+    static const size_t arena_page_size = 100;
+    saa_arena arena = saa_arena_create(arena_page_size);
+    STF_EXPECT(saa_arena_prefetch(&arena) == 0, .failure_msg = "prefetch on a plain arena was not supposed to allocate");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_reset_reuses_pages)
+{
+    static const size_t arena_page_size = 100;
+    static const size_t push_size = 60;
+    saa_arena arena = saa_arena_create(arena_page_size);
+    char *first = saa_arena_push(&arena, push_size);
+    char *second = saa_arena_push(&arena, push_size);
+    STF_EXPECT(arena.pages->next != NULL, .return_on_failure = true, .failure_msg = "second page is NULL");
+    saa_arena_reset(&arena);
+    STF_EXPECT(arena.pages->capacity == 0 && arena.pages->next == NULL, .failure_msg = "first page was not reset");
+    STF_EXPECT(arena.spares != NULL && arena.spares->count == 1, .return_on_failure = true, .failure_msg = "second page was not moved to spares");
+    STF_EXPECT(saa_arena_push(&arena, push_size) == first, .failure_msg = "reset arena did not reuse the first page");
+    STF_EXPECT(saa_arena_push(&arena, push_size) == second, .failure_msg = "reset arena did not reuse the second page");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, frame_arena_advance_keeps_previous_generation)
+{
+    static const size_t arena_page_size = 100;
+    saa_frame_arena frame = saa_frame_arena_create(arena_page_size, 2);
+    int *batch_a = saa_arena_push_value_int(saa_frame_arena_current(&frame), 7);
+    saa_arena *next = saa_frame_arena_advance(&frame);
+    STF_EXPECT(next == saa_frame_arena_current(&frame), .failure_msg = "advance did not return current generation");
+    int *batch_b = saa_arena_push_value_int(next, 77);
+    STF_EXPECT(*batch_a == 7, .failure_msg = "previous generation was clobbered");
+    STF_EXPECT(*batch_b == 77, .failure_msg = "values did not match");
+    STF_EXPECT(saa_frame_arena_generation(&frame, 1)->pages->data == (char *)batch_a, .failure_msg = "generation 1 is not the previous one");
+    saa_frame_arena_destroy(&frame);
+}
+
+STF_TEST_CASE(saa, frame_arena_steady_state_does_not_allocate)
+{
+    static const size_t arena_page_size = 100;
+    static const size_t push_size = 60;
+    static const size_t generations = 3;
+    saa_frame_arena frame = saa_frame_arena_create(arena_page_size, generations);
+    saa_arena_page *second_pages[3] = { NULL };
+    for (size_t batch = 0; batch < generations * 4; batch++) {
+        saa_arena *arena = saa_frame_arena_current(&frame);
+        (void)saa_arena_push(arena, push_size);
+        (void)saa_arena_push(arena, push_size);
+        if (batch < generations) {
+            second_pages[batch] = arena->pages->next;
+        } else {
+            STF_EXPECT(arena->pages->next == second_pages[batch % generations], .failure_msg = "batch allocated a new page");
+        }
+        (void)saa_frame_arena_advance(&frame);
+    }
+    saa_frame_arena_destroy(&frame);
+}
+
+STF_TEST_CASE(saa, arena_push_array_is_aligned)
+{
+    static const size_t arena_page_size = 100;
+    saa_arena arena = saa_arena_create(arena_page_size);
+    (void)saa_arena_push(&arena, 3);
+    double *pushed = saa_arena_push_array(&arena, double, 4);
+    STF_EXPECT(pushed != NULL, .return_on_failure = true, .failure_msg = "pushing did not return a valid pointer");
+    STF_EXPECT((uintptr_t)pushed % _Alignof(double) == 0, .failure_msg = "array is not aligned");
+    STF_EXPECT(arena.pages->capacity == sizeof(double) + sizeof(double) * 4, .failure_msg = "unexpected padding");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_push_array_larger_than_page)
+{
+    static const size_t arena_page_size = 100;
+    saa_arena arena = saa_arena_create(arena_page_size);
+    STF_EXPECT(saa_arena_push_array(&arena, double, 13) == NULL, .failure_msg = "array larger than page size was not supposed to be pushed");
+    STF_EXPECT(saa_arena_push_array(&arena, double, SIZE_MAX / 2) == NULL, .failure_msg = "overflowing array size was not supposed to be pushed");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_push_array_over_aligned)
+{
+    typedef struct
+    {
+        _Alignas(64) double lanes[8];
+    } saa_test_wide;
+    static const size_t arena_page_size = 1000;
+    saa_arena arena = saa_arena_create(arena_page_size);
+    (void)saa_arena_push(&arena, 3);
+    saa_test_wide *pushed = saa_arena_push_array(&arena, saa_test_wide, 4);
+    STF_EXPECT(pushed != NULL, .return_on_failure = true, .failure_msg = "pushing did not return a valid pointer");
+    STF_EXPECT((uintptr_t)pushed % _Alignof(saa_test_wide) == 0, .failure_msg = "array is not aligned");
+    pushed = saa_arena_push_array(&arena, saa_test_wide, 15);
+    STF_EXPECT(pushed != NULL, .return_on_failure = true, .failure_msg = "pushing on a fresh page did not return a valid pointer");
+    STF_EXPECT((uintptr_t)pushed % _Alignof(saa_test_wide) == 0, .failure_msg = "array on a fresh page is not aligned");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_push_empty_run)
+{
+    static const size_t arena_page_size = 100;
+    static const int values[] = { 1 };
+    saa_arena arena = saa_arena_create(arena_page_size);
+    STF_EXPECT(saa_arena_push_array(&arena, double, 0) == NULL, .failure_msg = "empty array was supposed to return NULL");
+    STF_EXPECT(saa_arena_push_copy_n(&arena, int, values, 0) == NULL, .failure_msg = "empty copy was supposed to return NULL");
+    STF_EXPECT(saa_arena_push_fill(&arena, int, 7, 0) == NULL, .failure_msg = "empty fill was supposed to return NULL");
+    STF_EXPECT(arena.pages->capacity == 0, .failure_msg = "empty runs were not supposed to take space");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_push_copy_n)
+{
+    static const size_t arena_page_size = 100;
+    static const int values[] = { 1, 2, 3, 4, 5, 6, 7 };
+    static const size_t count = sizeof(values) / sizeof(values[0]);
+    saa_arena arena = saa_arena_create(arena_page_size);
+    (void)saa_arena_push_value_string(&arena, "x");
+    int *pushed = saa_arena_push_copy_n(&arena, int, values, count);
+    STF_EXPECT(pushed != NULL, .return_on_failure = true, .failure_msg = "pushing did not return a valid pointer");
+    STF_EXPECT((uintptr_t)pushed % _Alignof(int) == 0, .failure_msg = "array is not aligned");
+    STF_EXPECT(memcmp(pushed, values, sizeof(values)) == 0, .failure_msg = "values did not match");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_push_fill)
+{
+    static const size_t arena_page_size = 1000;
+    static const size_t count = 77;
+    saa_arena arena = saa_arena_create(arena_page_size);
+    double *doubles = saa_arena_push_fill(&arena, double, 77.7, count);
+    STF_EXPECT(doubles != NULL, .return_on_failure = true, .failure_msg = "pushing did not return a valid pointer");
+    int *ints = saa_arena_push_fill(&arena, int, -1, count);
+    STF_EXPECT(ints != NULL, .return_on_failure = true, .failure_msg = "pushing did not return a valid pointer");
+    char *chars = saa_arena_push_fill(&arena, char, 'a', count);
+    STF_EXPECT(chars != NULL, .return_on_failure = true, .failure_msg = "pushing did not return a valid pointer");
+    bool all_match = true;
+    for (size_t i = 0; i < count; i++) {
+        all_match = all_match && doubles[i] == 77.7 && ints[i] == -1 && chars[i] == 'a';
+    }
+    STF_EXPECT(all_match, .failure_msg = "filled values did not match");
+    saa_arena_destroy(&arena);
+}
+
+STF_TEST_CASE(saa, arena_push_fill_struct)
+{
+    typedef struct
+    {
+        int x;
+        double y;
+    } saa_test_point;
+    static const size_t arena_page_size = 1000;
+    static const size_t count = 9;
+    const saa_test_point point = { .x = 7, .y = 77.7 };
+    saa_arena arena = saa_arena_create(arena_page_size);
+    saa_test_point *pushed = saa_arena_push_fill(&arena, saa_test_point, point, count);
+    STF_EXPECT(pushed != NULL, .return_on_failure = true, .failure_msg = "pushing did not return a valid pointer");
+    bool all_match = true;
+    for (size_t i = 0; i < count; i++) {
+        all_match = all_match && pushed[i].x == point.x && pushed[i].y == point.y;
+    }
+    STF_EXPECT(all_match, .failure_msg = "filled values did not match");
+    saa_arena_destroy(&arena);
+}
+
+#ifdef SAA_TEST_BENCHMARKS
+#include <stdio.h>
+#include <time.h>
+
+#define SAA_TEST_HISTOGRAM_BUCKETS 16
+
+static inline long long saa_test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline int saa_test_compare_latency(const void *a, const void *b)
+{
+    const long long lhs = *(const long long *)a;
+    const long long rhs = *(const long long *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static inline void saa_test_push_latency_histogram(const char *name, const saa_arena *arena, size_t push_size, size_t pushes)
+{
+    size_t histogram[SAA_TEST_HISTOGRAM_BUCKETS] = { 0 };
+    long long *latencies = malloc(sizeof(*latencies) * pushes);
+    for (size_t i = 0; i < pushes; i++) {
+        const long long begin = saa_test_now_ns();
+        (void)saa_arena_push(arena, push_size);
+        latencies[i] = saa_test_now_ns() - begin;
+        size_t bucket = 0;
+        for (long long elapsed = latencies[i]; elapsed > 1 && bucket < SAA_TEST_HISTOGRAM_BUCKETS - 1; elapsed >>= 1) bucket++;
+        histogram[bucket]++;
+        (void)saa_arena_prefetch(arena);
+    }
+    qsort(latencies, pushes, sizeof(*latencies), saa_test_compare_latency);
+    printf("%s push latency histogram (ns), p99 %lld, max %lld:\n", name, latencies[pushes * 99 / 100], latencies[pushes - 1]);
+    for (size_t bucket = 0; bucket < SAA_TEST_HISTOGRAM_BUCKETS - 1; bucket++) {
+        if (histogram[bucket] == 0) continue;
+        printf("    <  %8lld: %zu\n", 1LL << (bucket + 1), histogram[bucket]);
+    }
+    if (histogram[SAA_TEST_HISTOGRAM_BUCKETS - 1] != 0) {
+        printf("    >= %8lld: %zu\n", 1LL << (SAA_TEST_HISTOGRAM_BUCKETS - 1), histogram[SAA_TEST_HISTOGRAM_BUCKETS - 1]);
+    }
+    free(latencies);
+}
+
+STF_TEST_CASE(saa, benchmark_push_latency_histogram)
+{
+    static const size_t arena_page_size = 64 * 1024;
+    static const size_t push_size = 4 * 1024;
+    static const size_t pushes = 1024;
+    saa_arena plain = saa_arena_create(arena_page_size);
+    saa_test_push_latency_histogram("plain", &plain, push_size, pushes);
+    saa_arena_destroy(&plain);
+    saa_arena prefetched = saa_arena_create_prefetched(arena_page_size, 1, 0);
+    saa_test_push_latency_histogram("prefetched", &prefetched, push_size, pushes);
+    saa_arena_destroy(&prefetched);
+    STF_EXPECT(true, .failure_msg = "you will never see this");
+}
+#endif// SAA_TEST_BENCHMARKS
+
 // STF_TEST_CASE(saa, benchmark_initialization)
 // {
 //     static const size_t arena_page_size = 200;